@@ -3,6 +3,8 @@
 #include <iostream>
 #include <variant>
 
+#include "EventPool.h"
+
 template <typename T>
 class Event {
 public:
@@ -21,4 +23,4 @@ using EventF = Event<int>;
 using EventG = Event<int>;
 using EventH = Event<int>;
 
-using EventVariant = std::variant<std::monostate, EventA, EventB, EventC, EventD, EventE, EventF, EventG, EventH>;
+using EventVariant = std::variant<std::monostate, EventA, EventB, EventC, EventD, EventE, EventF, EventG, EventH, PooledEvent>;
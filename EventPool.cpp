@@ -0,0 +1,135 @@
+#include <algorithm>
+
+#include "EventPool.h"
+
+namespace {
+
+// Source of EventPool ids; 0 is never handed out so an empty cache never matches.
+std::atomic<uint64_t> next_pool_id{1};
+
+// Last producer pool used by this thread, tagged with the id of the EventPool owning it.
+struct LocalPoolCache {
+    uint64_t pool_id = 0;
+    ProducerPool* pool = nullptr;
+};
+
+thread_local LocalPoolCache local_pool_cache;
+
+}  // namespace
+
+ProducerPool::ProducerPool(std::thread::id owner_thread) : owner_thread_(owner_thread) {}
+
+ProducerPool::~ProducerPool() {
+    while (all_blocks_) {
+        PoolBlock* block = all_blocks_;
+        all_blocks_ = block->all_next;
+        std::destroy_at(block);
+        ::operator delete(static_cast<void*>(block));
+    }
+}
+
+PoolBlock* ProducerPool::Acquire(size_t size_class) {
+    PoolBlock* block = local_free_[size_class];
+
+    if (!block) {
+        // Take over everything the consumer has returned so far
+        block = returned_[size_class].exchange(nullptr, std::memory_order_acquire);
+    }
+
+    if (!block) {
+        // Warm-up only: grow the pool by one block
+        void* memory = ::operator new(sizeof(PoolBlock) + (POOL_MIN_BLOCK_SIZE << size_class));
+        block = std::construct_at(static_cast<PoolBlock*>(memory));
+        block->owner = this;
+        block->size_class = size_class;
+        block->all_next = all_blocks_;
+        all_blocks_ = block;
+    }
+
+    local_free_[size_class] = block->next;
+    block->next = nullptr;
+    return block;
+}
+
+void ProducerPool::ReturnBatch(size_t size_class, PoolBlock* first, PoolBlock* last) {
+    PoolBlock* head = returned_[size_class].load(std::memory_order_relaxed);
+    do {
+        last->next = head;
+    } while (!returned_[size_class].compare_exchange_weak(head, first, std::memory_order_release,
+                                                          std::memory_order_relaxed));
+}
+
+EventPool::EventPool() : pools_(nullptr), id_(next_pool_id.fetch_add(1, std::memory_order_relaxed)) {
+    pending_.reserve(POOL_SIZE_CLASS_COUNT * 16);
+}
+
+EventPool::~EventPool() {
+    ProducerPool* pool = pools_.load(std::memory_order_acquire);
+    while (pool) {
+        ProducerPool* next = pool->next_registered;
+        delete pool;
+        pool = next;
+    }
+}
+
+void EventPool::Recycle(const PooledEvent& event) {
+    PoolBlock* block = event.block;
+    block->destroy(block->Storage());
+
+    auto batch = std::ranges::find_if(pending_, [block](const PendingBatch& pending) {
+        return pending.owner == block->owner && pending.size_class == block->size_class;
+    });
+
+    if (batch == pending_.end()) {
+        pending_.push_back({block->owner, block->size_class, nullptr, nullptr, 0});
+        batch = std::prev(pending_.end());
+    }
+
+    // Chain the block into the batch of its owner
+    block->next = batch->first;
+    batch->first = block;
+    if (!batch->last) {
+        batch->last = block;
+    }
+
+    if (++batch->count >= POOL_RECYCLE_BATCH) {
+        batch->owner->ReturnBatch(batch->size_class, batch->first, batch->last);
+        batch->first = batch->last = nullptr;
+        batch->count = 0;
+    }
+}
+
+void EventPool::FlushRecycled() {
+    for (PendingBatch& batch : pending_) {
+        if (batch.count == 0) {
+            continue;
+        }
+        batch.owner->ReturnBatch(batch.size_class, batch.first, batch.last);
+        batch.first = batch.last = nullptr;
+        batch.count = 0;
+    }
+}
+
+ProducerPool& EventPool::LocalPool() {
+    if (local_pool_cache.pool_id == id_) {
+        return *local_pool_cache.pool;
+    }
+
+    const std::thread::id this_thread = std::this_thread::get_id();
+    ProducerPool* pool = pools_.load(std::memory_order_acquire);
+    while (pool && pool->OwnerThread() != this_thread) {
+        pool = pool->next_registered;
+    }
+
+    if (!pool) {
+        // Only this thread registers pools for its own id, so a plain push is enough
+        pool = new ProducerPool(this_thread);
+        pool->next_registered = pools_.load(std::memory_order_relaxed);
+        while (!pools_.compare_exchange_weak(pool->next_registered, pool, std::memory_order_release,
+                                             std::memory_order_relaxed)) {
+        }
+    }
+
+    local_pool_cache = {id_, pool};
+    return *pool;
+}
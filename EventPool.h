@@ -0,0 +1,186 @@
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+
+constexpr size_t POOL_MIN_BLOCK_SIZE = 64;    // Capacity of the smallest size class in bytes
+constexpr size_t POOL_SIZE_CLASS_COUNT = 8;   // Size classes 64B, 128B, ... 8KB
+constexpr size_t POOL_RECYCLE_BATCH = 32;     // Blocks handed back to a producer with a single CAS
+
+class ProducerPool;
+
+/**
+ * @struct PoolBlock
+ * @brief Header of a pooled block; the event object lives directly behind it.
+ *
+ * The header is aligned to std::max_align_t so the storage that follows it is suitably
+ * aligned for any event type.
+ */
+struct alignas(std::max_align_t) PoolBlock {
+    PoolBlock* next = nullptr;       ///< Link in a free list or in a recycle batch.
+    PoolBlock* all_next = nullptr;   ///< Link in the owner's list of every block it allocated.
+    ProducerPool* owner = nullptr;   ///< Producer pool the block has to be returned to.
+    size_t size_class = 0;           ///< Index of the size class the block belongs to.
+    void (*process)(void*) = nullptr;  ///< Calls Process() on the stored event.
+    void (*destroy)(void*) = nullptr;  ///< Calls the destructor of the stored event.
+
+    void* Storage() { return static_cast<void*>(this + 1); }
+};
+
+/**
+ * @struct PooledEvent
+ * @brief Handle stored in a ring slot in place of an event that does not fit into the slot.
+ */
+struct PooledEvent {
+    PoolBlock* block = nullptr;
+
+    /**
+     * @brief Retrieves the pointer to the pooled event object.
+     * @return Pointer to the event, or nullptr for an empty handle.
+     */
+    void* Get() const { return block ? block->Storage() : nullptr; }
+
+    /**
+     * @brief Processes the pooled event.
+     */
+    void Process() const { block->process(block->Storage()); }
+};
+
+/**
+ * @brief Returns the index of the smallest size class able to hold an object of type T.
+ */
+template <typename T>
+constexpr size_t PoolSizeClassOf() {
+    size_t size_class = 0;
+    while (size_class < POOL_SIZE_CLASS_COUNT && (POOL_MIN_BLOCK_SIZE << size_class) < sizeof(T)) {
+        ++size_class;
+    }
+    return size_class;
+}
+
+/**
+ * @class ProducerPool
+ * @brief Per-producer set of free lists, one per size class.
+ *
+ * The owning producer pops blocks from its private free list without any synchronization.
+ * The consumer hands destroyed blocks back in batches by pushing a whole chain onto the
+ * returned list with a single CAS; the producer takes that list over with one exchange
+ * once its private list runs dry, so no ABA problem can occur.
+ */
+class ProducerPool {
+public:
+    explicit ProducerPool(std::thread::id owner_thread);
+    ~ProducerPool();
+
+    ProducerPool(const ProducerPool&) = delete;
+    ProducerPool& operator=(const ProducerPool&) = delete;
+
+    /**
+     * @brief Takes a free block of the given size class. Only called by the owning producer.
+     *
+     * A new block is allocated only while the pool is warming up, i.e. when both the
+     * private and the returned free lists are empty.
+     *
+     * @param size_class The index of the size class.
+     * @return A block ready for constructing an event.
+     */
+    PoolBlock* Acquire(size_t size_class);
+
+    /**
+     * @brief Returns a chain of blocks of one size class to this pool. Called by the consumer.
+     *
+     * @param size_class The index of the size class of every block in the chain.
+     * @param first The first block of the chain.
+     * @param last The last block of the chain.
+     */
+    void ReturnBatch(size_t size_class, PoolBlock* first, PoolBlock* last);
+
+    std::thread::id OwnerThread() const { return owner_thread_; }
+
+    ProducerPool* next_registered = nullptr;  ///< Link in the EventPool registry.
+
+private:
+    std::array<PoolBlock*, POOL_SIZE_CLASS_COUNT> local_free_ = {};  ///< Producer-only free lists.
+    std::array<std::atomic<PoolBlock*>, POOL_SIZE_CLASS_COUNT> returned_ = {};  ///< Blocks recycled by the consumer.
+    PoolBlock* all_blocks_ = nullptr;  ///< Every block allocated by this pool, released in the destructor.
+    std::thread::id owner_thread_;
+};
+
+/**
+ * @class EventPool
+ * @brief Size-classed, lock-free object pool for events that do not fit into a ring slot.
+ *
+ * Each producer thread gets its own ProducerPool on first use. The consumer destroys the
+ * event and collects the block into a pending batch of its owner, which is handed back
+ * once it is full or the consumer goes idle. After warm-up, pooled events therefore need
+ * no allocations and no memory ever crosses threads through malloc/free.
+ */
+class EventPool {
+public:
+    EventPool();
+    ~EventPool();
+
+    EventPool(const EventPool&) = delete;
+    EventPool& operator=(const EventPool&) = delete;
+
+    /**
+     * @brief Constructs an event of type T in a pooled block. Called by producers.
+     *
+     * @tparam T The type of the event.
+     * @param args Arguments for constructing the event.
+     * @return A handle to the constructed event.
+     */
+    template <typename T, class... Args>
+    PooledEvent Create(Args&&... args);
+
+    /**
+     * @brief Destroys a pooled event and queues its block for return. Called by the consumer.
+     *
+     * @param event The handle of the event to destroy.
+     */
+    void Recycle(const PooledEvent& event);
+
+    /**
+     * @brief Hands all pending batches back to their producers. Called by the consumer.
+     */
+    void FlushRecycled();
+
+private:
+    struct PendingBatch {
+        ProducerPool* owner;
+        size_t size_class;
+        PoolBlock* first;
+        PoolBlock* last;
+        size_t count;
+    };
+
+    /**
+     * @brief Returns the ProducerPool of the calling thread, registering one if needed.
+     */
+    ProducerPool& LocalPool();
+
+    std::atomic<ProducerPool*> pools_;   ///< Registry of every producer pool, push-only.
+    std::vector<PendingBatch> pending_;  ///< Consumer-only batches waiting to be returned.
+    uint64_t id_;                        ///< Unique id used to validate the thread-local cache.
+};
+
+template <typename T, class... Args>
+PooledEvent EventPool::Create(Args&&... args) {
+    constexpr size_t size_class = PoolSizeClassOf<T>();
+    static_assert(size_class < POOL_SIZE_CLASS_COUNT, "Event type is too large for the event pool!");
+    static_assert(alignof(T) <= alignof(PoolBlock), "Event type is over-aligned for the event pool!");
+
+    PoolBlock* block = LocalPool().Acquire(size_class);
+    std::construct_at(static_cast<T*>(block->Storage()), std::forward<Args>(args)...);
+    block->process = [](void* event) { static_cast<T*>(event)->Process(); };
+    block->destroy = [](void* event) { std::destroy_at(static_cast<T*>(event)); };
+
+    return PooledEvent{block};
+}
@@ -5,8 +5,27 @@
 #include "IEventProcessor.h"
 
 IEventProcessor::IEventProcessor() 
-    : stop_(false) 
+    : IEventProcessor(LaneConfig{}) 
 {
+}
+
+IEventProcessor::IEventProcessor(const LaneConfig& config, const SharedMemoryConfig& shared_memory) 
+    : config_(config), shared_config_(shared_memory), stop_(false) 
+{
+    config_.lane_count = std::max<size_t>(config_.lane_count, 1);
+    config_.weights.resize(config_.lane_count, 1);
+    std::ranges::replace(config_.weights, size_t{0}, size_t{1});
+
+    for (size_t lane = 0; lane < config_.lane_count; ++lane) {
+        lanes_.push_back(std::make_unique<LockFreeEventQueue>(event_pool_));
+        lane_stats_.push_back(std::make_unique<LatencyStats>());
+    }
+    lane_skips_.assign(config_.lane_count, 0);
+
+    if (!shared_config_.name.empty()) {
+        shared_queue_ = SharedMemoryEventQueue::Create(shared_config_.name, shared_config_.capacity);
+    }
+
     // Start the worker thread for processing events
     worker_thread_ = std::thread([this] { ProcessEvents(); });
 }
@@ -78,28 +97,149 @@ bool IEventProcessor::ReservedEvents::IsValid() const
 //! should be ok
 void IEventProcessor::Commit(const Integer sequence_number) 
 {
-    queue_.Commit(sequence_number);
+    if (LockFreeEventQueue* const queue = LaneOf(sequence_number)) {
+        queue->Commit(sequence_number);
+    }
 }
 
 //! should be ok
 void IEventProcessor::Commit(const Integer sequence_number, const size_t count) 
 {
+    LockFreeEventQueue* const queue = LaneOf(sequence_number);
+    if (!queue) {
+        return;
+    }
+
     for (size_t i = 0; i < count; ++i) {
-        queue_.Commit(sequence_number + i);
+        queue->Commit(sequence_number + i);
     }
 }
 
+LockFreeEventQueue* IEventProcessor::LaneOf(const Integer sequence_number) const
+{
+    // Rejects the -1 of an invalid ReservedEvent as well as numbers beyond the configured lanes
+    if (sequence_number < 0 || static_cast<size_t>(sequence_number) / BUFFER_SIZE >= lanes_.size()) {
+        std::cerr << "Invalid sequence number " << sequence_number << "." << std::endl;
+        return nullptr;
+    }
+
+    return lanes_[static_cast<size_t>(sequence_number) / BUFFER_SIZE].get();
+}
+
 void IEventProcessor::ProcessEvents() {
+    size_t spin_count = 0;
+    size_t yield_count = 0;
+
     while (!stop_) {
-        // Process and remove events from the queue
-        while (auto event = queue_.Pop()) {
-            // Process the event; the logic will depend on your use case
-            // If events are of various types, you can use std::visit or other strategies to handle them
-            std::cout << "Processing event..." << std::endl;
+        if (Drain() > 0) {
+            spin_count = 0;
+            yield_count = 0;
+            continue;
+        }
+
+        // Idle: adaptive spin-waiting, handing recycled pool blocks back before giving up the CPU
+        if (spin_count < MAX_SPIN_COUNT) {
+            ++spin_count;
+        } else if (yield_count < MAX_YIELD_COUNT) {
+            event_pool_.FlushRecycled();
+            std::this_thread::yield();
+            ++yield_count;
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            yield_count = 0;
         }
+    }
 
-        // Yield to avoid blocking CPU when queue is empty
-        std::this_thread::yield();
+    // Process and destroy everything committed before the stop, pooled events included
+    while (Drain() > 0) {
     }
+    event_pool_.FlushRecycled();
+}
+
+size_t IEventProcessor::Drain() {
+    const size_t processed = config_.policy == DrainPolicy::StrictPriority
+        ? DrainStrictPriority()
+        : DrainWeightedRoundRobin();
+    return processed + DrainSharedMemory();
 }
 
+size_t IEventProcessor::DrainStrictPriority() {
+    // A lower-priority lane that has waited behind too many events is served once
+    for (size_t lane = 1; lane < lanes_.size(); ++lane) {
+        if (lane_skips_[lane] >= config_.starvation_limit && ProcessNext(lane)) {
+            lane_skips_[lane] = 0;
+            return 1;
+        }
+    }
+
+    for (size_t lane = 0; lane < lanes_.size(); ++lane) {
+        if (!ProcessNext(lane)) {
+            continue;
+        }
+
+        lane_skips_[lane] = 0;
+        for (size_t lower = lane + 1; lower < lanes_.size(); ++lower) {
+            lane_skips_[lower] = lanes_[lower]->IsEmpty() ? 0 : lane_skips_[lower] + 1;
+        }
+        return 1;
+    }
+
+    return 0;
+}
+
+size_t IEventProcessor::DrainWeightedRoundRobin() {
+    size_t processed = 0;
+    for (size_t lane = 0; lane < lanes_.size(); ++lane) {
+        for (size_t credit = 0; credit < config_.weights[lane] && ProcessNext(lane); ++credit) {
+            ++processed;
+        }
+    }
+    return processed;
+}
+
+bool IEventProcessor::ProcessNext(const size_t lane) {
+    LockFreeEventQueue& queue = *lanes_[lane];
+    EventClock::time_point reserved_at;
+
+    auto event = queue.TryPop(reserved_at);
+    if (!event) {
+        return false;
+    }
+
+    std::visit([&queue](auto& value) {
+        using T = std::decay_t<decltype(value)>;
+        if constexpr (std::is_same_v<T, PooledEvent>) {
+            // Pooled events are destroyed here and their block goes back to the producer
+            value.Process();
+            queue.Release(value);
+        } else if constexpr (!std::is_same_v<T, std::monostate>) {
+            value.Process();
+        }
+    }, *event);
+    event.reset();  // Inline events are destroyed here
+
+    lane_stats_[lane]->Record(EventClock::now() - reserved_at);
+    return true;
+}
+
+size_t IEventProcessor::DrainSharedMemory() {
+    if (!shared_queue_) {
+        return 0;
+    }
+
+    size_t processed = 0;
+    const auto process = [this](const uint32_t type_id, void* const event, const EventClock::time_point reserved_at) {
+        // The event is processed in place; its slot is freed once this returns
+        if (type_id < SHM_MAX_EVENT_TYPES) {
+            if (const auto handler = shared_handlers_[type_id].load(std::memory_order_acquire)) {
+                handler(event);
+            }
+        }
+        shared_stats_.Record(EventClock::now() - reserved_at);
+    };
+
+    while (processed < shared_config_.weight && shared_queue_->TryPop(process)) {
+        ++processed;
+    }
+    return processed;
+}
@@ -10,9 +10,57 @@
 #include <memory>
 #include <iostream>
 #include <optional>
+#include <string>
 
 #include "Event.h"
+#include "LatencyStats.h"
 #include "LockFreeEventQueue.h"
+#include "SharedMemoryEventQueue.h"
+#include "SpinWait.h"
+
+/**
+ * @brief Order in which the worker drains the priority lanes.
+ *
+ * The shared-memory ring is not a lane and sits outside this order: under either policy,
+ * every pass over the lanes is followed by up to SharedMemoryConfig::weight shared events.
+ */
+enum class DrainPolicy
+{
+    StrictPriority,      ///< Always serve the lowest-index non-empty lane, with starvation protection.
+    WeightedRoundRobin   ///< Serve up to weights[i] events from lane i per round.
+};
+
+/**
+ * @brief Configuration of the priority lanes of an IEventProcessor.
+ * 
+ * Lane 0 has the highest priority. Missing or zero weights are treated as 1.
+ */
+struct LaneConfig
+{
+    size_t lane_count = 1;                            ///< Number of lanes, each with its own ring.
+    DrainPolicy policy = DrainPolicy::StrictPriority; ///< How the worker picks the next lane.
+    size_t starvation_limit = 64;                     ///< StrictPriority: events served ahead of a waiting lane before it gets one.
+    std::vector<size_t> weights;                      ///< WeightedRoundRobin: events per round for each lane.
+};
+
+/**
+ * @brief Configuration of the optional shared-memory ring of an IEventProcessor.
+ */
+struct SharedMemoryConfig
+{
+    std::string name;              ///< If set, also create and drain a shared-memory ring of this name.
+    size_t capacity = BUFFER_SIZE; ///< Number of slots of the ring.
+    size_t weight = 1;             ///< Shared events served after each pass over the lanes.
+};
+
+/**
+ * @brief Lane an event type is published to by Reserve.
+ * 
+ * Specialize for an event type to route it, e.g. `template <> inline constexpr size_t EventLane<CancelEvent> = 0;`.
+ * Lanes beyond the configured count fall back to the last (lowest-priority) lane.
+ */
+template <typename T>
+inline constexpr size_t EventLane = 0;
 
 class IEventProcessor
 {
@@ -20,6 +68,7 @@ public:
     using Integer = int64_t;
 
     IEventProcessor();
+    explicit IEventProcessor(const LaneConfig& config, const SharedMemoryConfig& shared_memory = {});
     ~IEventProcessor();
 
     /**
@@ -149,6 +198,8 @@ public:
      * This method reserves memory in the event queue for a single event, 
      * constructs the event using the provided arguments, and returns a 
      * ReservedEvent object containing the reserved event data.
+     * Event types larger than a queue slot are placed in a pooled block instead,
+     * and GetEvent() of the result points to that block.
      * 
      * @tparam T The type of the event (e.g., EventA, EventB, etc.).
      * @param args Arguments for constructing the event.
@@ -157,6 +208,19 @@ public:
     template <class T, class... Args>
     ReservedEvent Reserve(Args&&... args);
 
+    /**
+     * @brief Reserves and constructs a single event in the given priority lane.
+     * 
+     * Same as Reserve, but overrides the lane selected by EventLane<T>.
+     * 
+     * @tparam T The type of the event (e.g., EventA, EventB, etc.).
+     * @param lane The index of the lane, 0 being the highest priority.
+     * @param args Arguments for constructing the event.
+     * @return A ReservedEvent object containing the reserved event data.
+     */
+    template <class T, class... Args>
+    ReservedEvent ReserveInLane(const size_t lane, Args&&... args);
+
     /**
      * @brief Reserves memory for a range of events and returns a collection of ReservedEvents.
      * 
@@ -190,12 +254,40 @@ public:
     void Commit(const Integer sequence_number, const size_t count);
 
     /**
-     * @brief Processes events in the event queue.
+     * @brief Registers the handler for a shared-memory event type.
      * 
-     * This method runs a loop to process events continuously, popping events 
-     * from the queue and performing necessary processing.
+     * Events published by other processes carry only their SharedEventType id, so each type
+     * must be registered before it can be processed; events of unknown types are dropped.
+     * 
+     * @tparam T The type of the event, with a SharedEventType id.
      */
-    void ProcessEvents();
+    template <class T>
+    void RegisterSharedEvent();
+
+    /**
+     * @brief Retrieves the shared-memory ring, or nullptr if the processor runs without one.
+     */
+    SharedMemoryEventQueue* GetSharedMemoryQueue() const { return shared_queue_.get(); }
+
+    /**
+     * @brief Retrieves the latency statistics of events received through shared memory.
+     */
+    const LatencyStats& GetSharedMemoryStats() const { return shared_stats_; }
+
+    /**
+     * @brief Retrieves the number of configured priority lanes.
+     */
+    size_t LaneCount() const { return lanes_.size(); }
+
+    /**
+     * @brief Retrieves the latency statistics of a lane.
+     * 
+     * Latency is measured from the start of Reserve until the event has been processed and destroyed.
+     * 
+     * @param lane The index of the lane.
+     * @return The statistics of the lane, safe to read while events are being processed.
+     */
+    const LatencyStats& GetLaneStats(const size_t lane) const { return *lane_stats_[lane]; }
 
     /**
      * @brief Publishes a single event to the event processor.
@@ -224,33 +316,110 @@ public:
     void PublishMultipleEvents(size_t count, Args&&... args);
 
 private:
-    LockFreeEventQueue queue_;
+    /**
+     * @brief Processes events in the event queue.
+     * 
+     * This method runs a loop to process events continuously, popping events 
+     * from the queue and performing necessary processing. Once stopped, it
+     * processes every event that was committed before returning.
+     * Runs only on worker_thread_; the lanes have a single consumer.
+     */
+    void ProcessEvents();
+
+    /**
+     * @brief Clamps a requested lane to the configured lanes.
+     */
+    size_t LaneIndex(const size_t lane) const { return std::min(lane, lanes_.size() - 1); }
+
+    /**
+     * @brief Encodes a lane and a slot index into a sequence number; Commit decodes the lane from it.
+     */
+    static Integer ToSequenceNumber(const size_t lane, const size_t index) { return static_cast<Integer>(lane * BUFFER_SIZE + index); }
+
+    /**
+     * @brief Decodes the lane of a sequence number.
+     * @return The lane's queue, or nullptr if the sequence number is invalid.
+     */
+    LockFreeEventQueue* LaneOf(const Integer sequence_number) const;
+
+    /**
+     * @brief Serves the lanes under the configured policy, then the shared-memory ring.
+     * @return The number of processed events.
+     */
+    size_t Drain();
+
+    /**
+     * @brief Serves one event under DrainPolicy::StrictPriority.
+     * @return The number of processed events.
+     */
+    size_t DrainStrictPriority();
+
+    /**
+     * @brief Serves one round under DrainPolicy::WeightedRoundRobin.
+     * @return The number of processed events.
+     */
+    size_t DrainWeightedRoundRobin();
+
+    /**
+     * @brief Pops, processes and destroys the next event of a lane and records its latency.
+     * @return False if the lane had no committed event.
+     */
+    bool ProcessNext(const size_t lane);
+
+    /**
+     * @brief Pops, processes and records up to SharedMemoryConfig::weight events from the shared-memory ring.
+     * @return The number of processed events.
+     */
+    size_t DrainSharedMemory();
+
+    LaneConfig config_;
+    SharedMemoryConfig shared_config_;
+    EventPool event_pool_;  ///< Shared by all lanes so each producer thread has a single ProducerPool.
+    std::vector<std::unique_ptr<LockFreeEventQueue>> lanes_;
+    std::vector<std::unique_ptr<LatencyStats>> lane_stats_;
+    std::vector<size_t> lane_skips_;  ///< Worker-only: events served ahead of each waiting lane.
+    std::unique_ptr<SharedMemoryEventQueue> shared_queue_;
+    std::array<std::atomic<void (*)(void*)>, SHM_MAX_EVENT_TYPES> shared_handlers_ = {};
+    LatencyStats shared_stats_;
     std::atomic<bool> stop_;
     std::thread worker_thread_;
 };
 
 
+template <class T>
+void IEventProcessor::RegisterSharedEvent() {
+    static_assert(SharedEventType<T> != 0 && SharedEventType<T> < SHM_MAX_EVENT_TYPES,
+                  "Specialize SharedEventType with a valid id for this event type!");
+
+    shared_handlers_[SharedEventType<T>].store([](void* event) { static_cast<T*>(event)->Process(); },
+                                               std::memory_order_release);
+}
+
 template <typename T, class... Args>
 std::pair<size_t, void*> IEventProcessor::ReserveEvent(Args&&... args) {
-    // Forward the arguments to the queue's ReserveEvent function
-    return queue_.ReserveEvent<T>(std::forward<Args>(args)...);
+    const auto reserved_event = Reserve<T>(std::forward<Args>(args)...);
+    return {static_cast<size_t>(reserved_event.GetSequenceNumber()), reserved_event.GetEvent()};
 }
 
 template <class T, class... Args>
 IEventProcessor::ReservedEvent IEventProcessor::Reserve(Args&&... args) {
-    // Reserve memory for the event in the queue
-    const auto reservation = ReserveEvent<T>(std::forward<Args>(args)...);
+    return ReserveInLane<T>(EventLane<T>, std::forward<Args>(args)...);
+}
 
-    // If the reservation failed, return an invalid ReservedEvent
-    if (!reservation.second) {
-        return ReservedEvent(); //! TODO: handle this case
+template <class T, class... Args>
+IEventProcessor::ReservedEvent IEventProcessor::ReserveInLane(const size_t lane, Args&&... args) {
+    const size_t index = LaneIndex(lane);
+    LockFreeEventQueue& queue = *lanes_[index];
+
+    // Events larger than a slot are constructed in the event pool; the slot only holds a handle
+    if constexpr (IsPooledEvent<T>) {
+        const auto reservation = queue.ReserveLargeEvent<T>(std::forward<Args>(args)...);
+        return ReservedEvent(ToSequenceNumber(index, reservation.first), reservation.second);
+    } else {
+        // Reserve a slot in the queue and construct the event directly in it; this waits rather than fails
+        const auto reservation = queue.ReserveInlineEvent<T>(std::forward<Args>(args)...);
+        return ReservedEvent(ToSequenceNumber(index, reservation.first), reservation.second);
     }
-
-    // Construct the event in the reserved memory location
-    std::construct_at(reinterpret_cast<T*>(reservation.second), std::forward<Args>(args)...);
-
-    // Return the reserved event, including the sequence number and pointer
-    return ReservedEvent(reservation.first, reservation.second);
 }
 
 
@@ -282,7 +451,7 @@ IEventProcessor::ReservedEvent IEventProcessor::Reserve(Args&&... args) {
 
 // Implementation of PublishEvent - Publishes a single event to the processor.
 template <typename TEvent, typename... Args>
-void PublishSingleEvents(IEventProcessor& processor, size_t count, Args&&... args)
+void IEventProcessor::PublishSingleEvents(IEventProcessor& processor, size_t count, Args&&... args)
 {
     static_assert(std::disjunction_v<std::is_same<TEvent, EventA>,
                                      std::is_same<TEvent, EventB>,
@@ -0,0 +1,72 @@
+#include <bit>
+
+#include "LatencyStats.h"
+
+void LatencyStats::Record(EventClock::duration latency) {
+    const auto ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count());
+
+    // Single writer: plain load/store pairs are enough, readers only need untorn values
+    auto& bucket = buckets_[BucketOf(ns)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    sum_ns_.store(sum_ns_.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+    if (ns > max_ns_.load(std::memory_order_relaxed)) {
+        max_ns_.store(ns, std::memory_order_relaxed);
+    }
+    count_.store(count_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+double LatencyStats::AverageNs() const {
+    const uint64_t count = Count();
+    return count ? static_cast<double>(sum_ns_.load(std::memory_order_relaxed)) / count : 0.0;
+}
+
+uint64_t LatencyStats::PercentileNs(double percentile) const {
+    uint64_t total = 0;
+    for (const auto& bucket : buckets_) {
+        total += bucket.load(std::memory_order_relaxed);
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    const auto rank = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(total - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < LATENCY_BUCKET_COUNT; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return BucketUpperBound(i);
+        }
+    }
+    return MaxNs();
+}
+
+void LatencyStats::Print(std::ostream& out) const {
+    out << "count=" << Count()
+        << " avg=" << AverageNs() << "ns"
+        << " p50=" << PercentileNs(50.0) << "ns"
+        << " p99=" << PercentileNs(99.0) << "ns"
+        << " max=" << MaxNs() << "ns";
+}
+
+size_t LatencyStats::BucketOf(uint64_t ns) {
+    constexpr uint64_t sub_bucket_count = uint64_t{1} << LATENCY_SUB_BUCKET_BITS;
+    if (ns < sub_bucket_count) {
+        return static_cast<size_t>(ns);
+    }
+
+    // Bucket group by the most significant bit, sub-bucket by the bits right below it
+    const size_t msb = static_cast<size_t>(std::bit_width(ns)) - 1;
+    const size_t sub = static_cast<size_t>(ns >> (msb - LATENCY_SUB_BUCKET_BITS)) & (sub_bucket_count - 1);
+    return ((msb - LATENCY_SUB_BUCKET_BITS + 1) << LATENCY_SUB_BUCKET_BITS) + sub;
+}
+
+uint64_t LatencyStats::BucketUpperBound(size_t bucket) {
+    constexpr uint64_t sub_bucket_count = uint64_t{1} << LATENCY_SUB_BUCKET_BITS;
+    if (bucket < sub_bucket_count) {
+        return bucket;
+    }
+
+    const size_t shift = (bucket >> LATENCY_SUB_BUCKET_BITS) - 1;
+    const uint64_t sub = bucket & (sub_bucket_count - 1);
+    return ((sub_bucket_count + sub + 1) << shift) - 1;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+using EventClock = std::chrono::steady_clock;
+
+constexpr size_t LATENCY_SUB_BUCKET_BITS = 2;  // 4 sub-buckets per power of two, i.e. <25% error
+constexpr size_t LATENCY_BUCKET_COUNT = 64 << LATENCY_SUB_BUCKET_BITS;
+
+/**
+ * @class LatencyStats
+ * @brief Log-linear latency histogram with average and worst case.
+ *
+ * Written by a single thread (the event processor's worker) and readable from any
+ * thread; every field is a relaxed atomic so readers only ever see a slightly stale view.
+ */
+class LatencyStats {
+public:
+    /**
+     * @brief Records one latency sample. Must only be called by the writer thread.
+     * @param latency The measured latency.
+     */
+    void Record(EventClock::duration latency);
+
+    /**
+     * @brief Retrieves the number of recorded samples.
+     */
+    uint64_t Count() const { return count_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Retrieves the average latency in nanoseconds.
+     */
+    double AverageNs() const;
+
+    /**
+     * @brief Retrieves the worst recorded latency in nanoseconds.
+     */
+    uint64_t MaxNs() const { return max_ns_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Retrieves the upper bound of the bucket containing the given percentile.
+     * @param percentile The percentile in the range (0, 100].
+     * @return The latency in nanoseconds, 0 if nothing has been recorded.
+     */
+    uint64_t PercentileNs(double percentile) const;
+
+    /**
+     * @brief Prints count, average, p50, p99 and worst latency.
+     */
+    void Print(std::ostream& out) const;
+
+private:
+    static size_t BucketOf(uint64_t ns);
+    static uint64_t BucketUpperBound(size_t bucket);
+
+    std::array<std::atomic<uint64_t>, LATENCY_BUCKET_COUNT> buckets_ = {};
+    std::atomic<uint64_t> count_ = 0;
+    std::atomic<uint64_t> sum_ns_ = 0;
+    std::atomic<uint64_t> max_ns_ = 0;
+};
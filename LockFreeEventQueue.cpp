@@ -2,57 +2,42 @@
 
 #include "LockFreeEventQueue.h"
 
-LockFreeEventQueue::LockFreeEventQueue() : head_(0), tail_(0) {}
+LockFreeEventQueue::LockFreeEventQueue(EventPool& pool) : head_(0), tail_(0), pool_(pool) {}
+
+LockFreeEventQueue::~LockFreeEventQueue() {
+    const uint64_t head = head_.load(std::memory_order_acquire);
+    for (uint64_t position = tail_.load(std::memory_order_relaxed); position != head; ++position) {
+        if (const auto* pooled = std::get_if<PooledEvent>(&buffer_[position % BUFFER_SIZE])) {
+            Release(*pooled);
+        }
+    }
+}
 
 void LockFreeEventQueue::Commit(size_t sequence_number) {
     committed_flags_[sequence_number % BUFFER_SIZE].store(true, std::memory_order_release);
 }
 
+void LockFreeEventQueue::Release(const PooledEvent& event) {
+    pool_.Recycle(event);
+}
+
 void LockFreeEventQueue::Enqueue(size_t index, EventVariant&& event) {
     buffer_[index % BUFFER_SIZE] = std::move(event);
 }
 
-std::optional<EventVariant> LockFreeEventQueue::Pop() {
-    size_t tail, spin_count = 0, yield_count = 0;
-
-    // Adaptive spin-waiting: we spin until we find an event, then perform yield or sleep as necessary
-    do {
-        tail = tail_.load(std::memory_order_relaxed);
-
-        // Check if the queue is empty (tail == head)
-        if (tail == head_.load(std::memory_order_acquire)) {
-            if (spin_count < MAX_SPIN_COUNT) {
-                ++spin_count;  // Increment spin counter
-                continue;       // Spin to check again
-            } else if (yield_count < MAX_YIELD_COUNT) {
-                std::this_thread::yield();  // Yield CPU to allow other threads to run
-                ++yield_count;
-            } else {
-                std::this_thread::sleep_for(std::chrono::microseconds(100));  // Sleep to reduce CPU usage
-                yield_count = 0;  // Reset yield count after sleep
-            }
-        }
+std::optional<EventVariant> LockFreeEventQueue::TryPop(EventClock::time_point& reserved_at) {
+    const uint64_t tail = tail_.load(std::memory_order_relaxed);
+    const size_t index = tail % BUFFER_SIZE;
 
-        // Check if the event is committed before processing
-        if (!committed_flags_[tail % BUFFER_SIZE].load(std::memory_order_acquire)) {
-            if (spin_count < MAX_SPIN_COUNT) {
-                ++spin_count;
-                continue;  // Spin again if not committed
-            } else if (yield_count < MAX_YIELD_COUNT) {
-                std::this_thread::yield();
-                ++yield_count;
-            } else {
-                std::this_thread::sleep_for(std::chrono::microseconds(100));  // Sleep after excessive yields
-                yield_count = 0;  // Reset yield count after sleep
-            }
-        }
+    if (tail == head_.load(std::memory_order_acquire) ||
+        !committed_flags_[index].load(std::memory_order_acquire)) {
+        return std::nullopt;  // Empty, or the oldest reservation is not committed yet
+    }
 
-        // If we've reached here, the event is available and committed
-        EventVariant event = std::move(buffer_[tail % BUFFER_SIZE]);
-        committed_flags_[tail % BUFFER_SIZE].store(false, std::memory_order_release); // Reset flag
-        tail_.store((tail + 1) % BUFFER_SIZE, std::memory_order_release);  // Update the tail
+    EventVariant event = std::move(buffer_[index]);
+    reserved_at = reserved_at_[index];
+    committed_flags_[index].store(false, std::memory_order_release); // Reset flag
+    tail_.store(tail + 1, std::memory_order_release);  // Update the tail
 
-        return event;
-    } while (true);  // Keep looping until an event is found and returned
+    return event;
 }
-
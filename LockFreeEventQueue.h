@@ -3,16 +3,40 @@
 #include <atomic>
 #include <array>
 #include <chrono>
+#include <cstdint>
 #include <variant>
 #include <optional>
 #include <iostream>
 #include <thread>
+#include <type_traits>
 
 #include "Event.h"
+#include "EventPool.h"
+#include "LatencyStats.h"
+#include "SpinWait.h"
 
 constexpr size_t BUFFER_SIZE = 1024;
-constexpr size_t MAX_SPIN_COUNT = 1000;  // Number of spins before yielding CPU
-constexpr size_t MAX_YIELD_COUNT = 10;   // Number of yields before sleeping
+
+/**
+ * @brief True for event types that do not fit into a ring slot and are stored in the EventPool.
+ */
+template <typename T>
+inline constexpr bool IsPooledEvent = sizeof(T) > sizeof(EventVariant);
+
+/**
+ * @brief Index of the first EventVariant alternative of type T.
+ * 
+ * Several event aliases name the same type, so alternatives are addressed by index rather than by type.
+ */
+template <typename T, size_t I = 0>
+constexpr size_t EventVariantIndex() {
+    static_assert(I < std::variant_size_v<EventVariant>, "Event type is not an EventVariant alternative!");
+    if constexpr (std::is_same_v<std::variant_alternative_t<I, EventVariant>, T>) {
+        return I;
+    } else {
+        return EventVariantIndex<T, I + 1>();
+    }
+}
 
 /**
  * @class LockFreeEventQueue
@@ -24,20 +48,48 @@ class LockFreeEventQueue {
 public:
     /**
      * @brief Constructor initializes the queue.
+     * @param pool Out-of-line storage for events larger than a slot; may be shared with other queues and must outlive this one.
      */
-    LockFreeEventQueue();
+    explicit LockFreeEventQueue(EventPool& pool);
 
     /**
-     * @brief Reserve a slot for an event in the queue.
+     * @brief Destructor destroys pooled events still in the queue before their pool goes away.
+     */
+    ~LockFreeEventQueue();
+
+    /**
+     * @brief Reserve a slot and construct an event of type T directly in it.
+     * 
+     * If the queue is full, it waits (spins) until space is available.
+     * 
+     * @tparam T The event type, an EventVariant alternative.
+     * @param args Arguments for constructing the event.
+     * @return A pair of the reserved index and a pointer to the constructed event.
+     */
+    template <typename T, class... Args>
+    std::pair<size_t, void*> ReserveInlineEvent(Args&&... args);
+
+    /**
+     * @brief Reserve a slot for an event that is too large to be stored in the slot itself.
      * 
-     * This function tries to reserve space for an event. If the queue is full, it waits (spins) until space is available.
+     * The event is constructed in a block taken from the calling producer's pool and the
+     * slot only holds a PooledEvent handle to it.
      * 
      * @tparam T The event type.
-     * @param event The event to be enqueued.
-     * @return A pair of the reserved index and a pointer to the stored event.
+     * @param args Arguments for constructing the event.
+     * @return A pair of the reserved index and a pointer to the pooled event.
      */
-    template <typename T>
-    std::pair<size_t, void*> ReserveEvent(T&& event);
+    template <typename T, class... Args>
+    std::pair<size_t, void*> ReserveLargeEvent(Args&&... args);
+
+    /**
+     * @brief Destroy a popped pooled event and recycle its block to the owning producer.
+     * 
+     * Must only be called by the consumer.
+     * 
+     * @param event The handle popped from the queue.
+     */
+    void Release(const PooledEvent& event);
 
     /**
      * @brief Commit an event to signal that it is ready to be processed.
@@ -57,35 +109,56 @@ public:
     void Enqueue(size_t index, EventVariant&& event);
 
     /**
-     * @brief Pop an event from the queue.
-     * 
-     * If an event is available and committed, it is removed from the queue and returned.
+     * @brief Pop an event from the queue without waiting.
      * 
-     * @return An optional EventVariant. If no event is available, std::nullopt is returned.
+     * @param reserved_at Set to the time the event's Reserve started when an event is returned.
+     * @return An optional EventVariant. If the next slot is empty or not committed yet, std::nullopt is returned.
+     */
+    std::optional<EventVariant> TryPop(EventClock::time_point& reserved_at);
+
+    /**
+     * @brief Check whether the queue holds no reserved events. Consumer-side view.
      */
-    std::optional<EventVariant> Pop();
+    bool IsEmpty() const { return tail_.load(std::memory_order_relaxed) == head_.load(std::memory_order_acquire); }
 
 private:
+    /**
+     * @brief Claim the next slot and construct the variant alternative I in it.
+     * 
+     * @param reserved_at The time the reservation started, used for latency measurement.
+     * @param args Arguments for constructing the alternative.
+     * @return A pair of the reserved index and a pointer to the stored event.
+     */
+    template <size_t I, class... Args>
+    std::pair<size_t, void*> ReserveSlot(EventClock::time_point reserved_at, Args&&... args);
+
+
     std::array<EventVariant, BUFFER_SIZE> buffer_;  ///< Circular buffer storing events.
     std::array<std::atomic<bool>, BUFFER_SIZE> committed_flags_ = {}; ///< Flags to indicate committed events.
-    std::atomic<size_t> head_, tail_; ///< Atomic counters for head and tail.
+    std::array<EventClock::time_point, BUFFER_SIZE> reserved_at_; ///< Reserve start time of each slot's event.
+    std::atomic<uint64_t> head_, tail_; ///< Monotonic counters for head and tail; the slot is the counter % BUFFER_SIZE.
+    EventPool& pool_; ///< Out-of-line storage for events larger than a slot.
 };
 
-template <typename T>
-std::pair<size_t, void*> LockFreeEventQueue::ReserveEvent(T&& event) {
-    size_t head, next_head;
+template <typename T, class... Args>
+std::pair<size_t, void*> LockFreeEventQueue::ReserveInlineEvent(Args&&... args) {
+    return ReserveSlot<EventVariantIndex<T>()>(EventClock::now(), std::forward<Args>(args)...);
+}
+
+template <size_t I, class... Args>
+std::pair<size_t, void*> LockFreeEventQueue::ReserveSlot(EventClock::time_point reserved_at, Args&&... args) {
+    uint64_t head;
     size_t spin_count = 0;
     size_t yield_count = 0;
 
-    do {
+    while (true) {
+        // Counters never wrap back, so a CAS with a stale head can never succeed after the ring has cycled
         head = head_.load(std::memory_order_relaxed);
-        next_head = (head + 1) % BUFFER_SIZE;
 
-        if (next_head == tail_.load(std::memory_order_acquire)) {
+        if (head - tail_.load(std::memory_order_acquire) >= BUFFER_SIZE) {
             // Buffer is full, use adaptive spin-waiting
             if (spin_count < MAX_SPIN_COUNT) {
                 ++spin_count;  // Increment spin counter
-                continue;       // Try again, spinning
             } else if (yield_count < MAX_YIELD_COUNT) {
                 std::this_thread::yield();  // Yield CPU to allow other threads to run
                 ++yield_count;
@@ -93,9 +166,26 @@ std::pair<size_t, void*> LockFreeEventQueue::ReserveEvent(T&& event) {
                 std::this_thread::sleep_for(std::chrono::microseconds(100));  // Sleep to reduce CPU usage
                 yield_count = 0;  // Reset yield count after sleep
             }
+            continue;  // Never claim a slot the consumer has not released yet
         }
-    } while (!head_.compare_exchange_weak(head, next_head, std::memory_order_release));
 
-    buffer_[head].emplace<T>(std::forward<T>(event));  // Store the event using move semantics
-    return {head, static_cast<void*>(&buffer_[head])};
+        if (head_.compare_exchange_weak(head, head + 1, std::memory_order_release)) {
+            break;
+        }
+    }
+
+    const size_t index = head % BUFFER_SIZE;
+    auto& event = buffer_[index].emplace<I>(std::forward<Args>(args)...);  // Construct the event in place
+    reserved_at_[index] = reserved_at;  // Published to the consumer by Commit
+    return {index, static_cast<void*>(&event)};
+}
+
+template <typename T, class... Args>
+std::pair<size_t, void*> LockFreeEventQueue::ReserveLargeEvent(Args&&... args) {
+    const auto reserved_at = EventClock::now();
+    PooledEvent pooled = pool_.Create<T>(std::forward<Args>(args)...);
+    void* const event = pooled.Get();
+
+    const auto reservation = ReserveSlot<EventVariantIndex<PooledEvent>()>(reserved_at, pooled);  // The slot only stores the handle
+    return {reservation.first, event};
 }
@@ -0,0 +1,307 @@
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <iostream>
+#include <thread>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "SharedMemoryEventQueue.h"
+#include "SpinWait.h"
+
+namespace {
+
+// Slots start on their own cache line right after the header
+constexpr uint64_t SlotsOffset() {
+    return (sizeof(SharedRingHeader) + alignof(SharedSlot) - 1) / alignof(SharedSlot) * alignof(SharedSlot);
+}
+
+// A zombie still answers kill(pid, 0), so its state is read from /proc first.
+// Pid reuse can only delay recovery, never skip a live process.
+bool IsProcessAlive(uint32_t pid) {
+    std::ifstream stat_file("/proc/" + std::to_string(pid) + "/stat");
+    std::string line;
+    if (stat_file && std::getline(stat_file, line)) {
+        // The state follows the parenthesized command name, which may itself contain ')'
+        const size_t name_end = line.rfind(')');
+        if (name_end != std::string::npos && name_end + 2 < line.size()) {
+            const char state = line[name_end + 2];
+            return state != 'Z' && state != 'X';
+        }
+    }
+
+    return kill(static_cast<pid_t>(pid), 0) == 0 || errno != ESRCH;
+}
+
+// Pids are only comparable within one pid namespace
+uint64_t PidNamespace() {
+    struct stat info {};
+    return stat("/proc/self/ns/pid", &info) == 0 ? static_cast<uint64_t>(info.st_ino) : 0;
+}
+
+// Unlinks a segment whose consumer died, so it cannot block a restart.
+// Producers still mapping it see the cleared magic and stop waiting on it.
+// A segment without a recorded owner may still be initializing and is left alone.
+bool RemoveStaleSegment(const std::string& name) {
+    const int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd == -1) {
+        return errno == ENOENT;  // Already gone
+    }
+
+    struct stat info {};
+    void* memory = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(SharedRingHeader)) {
+        memory = mmap(nullptr, sizeof(SharedRingHeader), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+
+    if (memory == MAP_FAILED) {
+        std::cerr << "Shared memory " << name << " is not an event queue or is still being created." << std::endl;
+        return false;
+    }
+
+    auto* header = static_cast<SharedRingHeader*>(memory);
+    const uint32_t owner = header->owner_pid.load(std::memory_order_acquire);
+    const bool stale = owner != 0 && !IsProcessAlive(owner);
+    if (stale) {
+        header->magic.store(0, std::memory_order_release);
+    }
+    munmap(memory, sizeof(SharedRingHeader));
+
+    if (!stale) {
+        std::cerr << "Shared memory " << name << " is in use or still being initialized." << std::endl;
+        return false;
+    }
+
+    std::cerr << "Replacing stale shared memory " << name << " left by a dead consumer." << std::endl;
+    return shm_unlink(name.c_str()) == 0 || errno == ENOENT;
+}
+
+// Identifies the segment currently behind a name, 0 if there is none
+uint64_t SegmentInode(const std::string& name) {
+    const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd == -1) {
+        return 0;
+    }
+
+    struct stat info {};
+    const uint64_t inode = fstat(fd, &info) == 0 ? static_cast<uint64_t>(info.st_ino) : 0;
+    close(fd);
+    return inode;
+}
+
+}  // namespace
+
+std::unique_ptr<SharedMemoryEventQueue> SharedMemoryEventQueue::Create(const std::string& name, size_t capacity) {
+    if (capacity < 2) {
+        std::cerr << "Shared-memory queue needs at least 2 slots." << std::endl;
+        return nullptr;
+    }
+
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd == -1 && errno == EEXIST && RemoveStaleSegment(name)) {
+        fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    }
+    if (fd == -1) {
+        std::cerr << "Failed to create shared memory " << name << ": " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+
+    const size_t size = SlotsOffset() + capacity * sizeof(SharedSlot);
+    struct stat info {};
+    void* memory = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && ftruncate(fd, static_cast<off_t>(size)) == 0) {
+        memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+
+    if (memory == MAP_FAILED) {
+        std::cerr << "Failed to map shared memory " << name << ": " << std::strerror(errno) << std::endl;
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+
+    auto* base = static_cast<std::byte*>(memory);
+    auto* header = std::construct_at(reinterpret_cast<SharedRingHeader*>(base));
+    header->owner_pid.store(static_cast<uint32_t>(getpid()), std::memory_order_release);
+    header->pid_namespace = PidNamespace();
+    header->capacity = capacity;
+    header->slots_offset = SlotsOffset();
+    header->abandoned.store(0, std::memory_order_relaxed);
+    header->head.store(0, std::memory_order_relaxed);
+    header->tail.store(0, std::memory_order_relaxed);
+
+    auto* slots = reinterpret_cast<SharedSlot*>(base + header->slots_offset);
+    for (uint64_t position = 0; position < capacity; ++position) {
+        std::construct_at(&slots[position]);
+        slots[position].state.store(MakeState(position, 0), std::memory_order_relaxed);
+    }
+
+    // Attaching producers only trust the segment once the magic is visible
+    header->magic.store(SHM_MAGIC, std::memory_order_release);
+
+    return std::unique_ptr<SharedMemoryEventQueue>(new SharedMemoryEventQueue(name, base, size, static_cast<uint64_t>(info.st_ino)));
+}
+
+std::unique_ptr<SharedMemoryEventQueue> SharedMemoryEventQueue::Attach(const std::string& name) {
+    const int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd == -1) {
+        std::cerr << "Failed to open shared memory " << name << ": " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+
+    struct stat info {};
+    void* memory = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(SharedRingHeader)) {
+        memory = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+
+    if (memory == MAP_FAILED) {
+        std::cerr << "Failed to map shared memory " << name << "." << std::endl;
+        return nullptr;
+    }
+
+    const auto size = static_cast<size_t>(info.st_size);
+    auto* base = static_cast<std::byte*>(memory);
+    const auto* header = reinterpret_cast<const SharedRingHeader*>(base);
+    if (header->magic.load(std::memory_order_acquire) != SHM_MAGIC ||
+        header->slots_offset != SlotsOffset() ||
+        size < header->slots_offset + header->capacity * sizeof(SharedSlot)) {
+        std::cerr << "Shared memory " << name << " is not an initialized event queue." << std::endl;
+        munmap(memory, size);
+        return nullptr;
+    }
+
+    const uint64_t pid_namespace = PidNamespace();
+    if (header->pid_namespace != 0 && pid_namespace != 0 && header->pid_namespace != pid_namespace) {
+        std::cerr << "Shared memory " << name << " belongs to another pid namespace." << std::endl;
+        munmap(memory, size);
+        return nullptr;
+    }
+
+    return std::unique_ptr<SharedMemoryEventQueue>(new SharedMemoryEventQueue(name, base, size, 0));
+}
+
+SharedMemoryEventQueue::SharedMemoryEventQueue(std::string name, std::byte* base, size_t size, uint64_t owned_inode)
+    : name_(std::move(name)),
+      base_(base),
+      size_(size),
+      owned_inode_(owned_inode),
+      pid_(static_cast<uint32_t>(getpid())),
+      header_(reinterpret_cast<SharedRingHeader*>(base))
+{
+}
+
+SharedMemoryEventQueue::~SharedMemoryEventQueue() {
+    if (owned_inode_ != 0) {
+        header_->magic.store(0, std::memory_order_release);  // Producers still attached stop waiting
+        // The name may already belong to a newer consumer that replaced this segment as stale
+        if (SegmentInode(name_) == owned_inode_) {
+            shm_unlink(name_.c_str());
+        }
+    }
+    munmap(base_, size_);
+}
+
+bool SharedMemoryEventQueue::Commit(const Reservation& reservation) {
+    uint64_t expected = MakeState(reservation.sequence, pid_);
+    return SlotAt(reservation.sequence).state.compare_exchange_strong(
+        expected, MakeState(reservation.sequence + 1, 0), std::memory_order_release, std::memory_order_relaxed);
+}
+
+SharedSlot& SharedMemoryEventQueue::SlotAt(uint64_t position) const {
+    auto* slots = reinterpret_cast<SharedSlot*>(base_ + header_->slots_offset);
+    return slots[position % header_->capacity];
+}
+
+bool SharedMemoryEventQueue::ClaimSlot(uint64_t& position) {
+    size_t spin_count = 0;
+    size_t yield_count = 0;
+    auto owner_checked_at = EventClock::now();
+
+    while (true) {
+        uint64_t head = header_->head.load(std::memory_order_acquire);
+        SharedSlot& slot = SlotAt(head);
+        uint64_t state = slot.state.load(std::memory_order_acquire);
+        const auto lap = static_cast<int32_t>(static_cast<uint32_t>(state >> 32) - static_cast<uint32_t>(head));
+
+        if (lap == 0 && (state & 0xffffffff) == 0) {
+            // Free: take it together with our pid, then move the head on
+            if (slot.state.compare_exchange_weak(state, MakeState(head, pid_), std::memory_order_acquire,
+                                                 std::memory_order_relaxed)) {
+                position = head;
+                header_->head.compare_exchange_strong(head, head + 1, std::memory_order_release);
+                return true;
+            }
+            continue;
+        }
+
+        if (lap == 0) {
+            // Claimed by a producer that has not moved the head yet (or died doing so): help it
+            header_->head.compare_exchange_strong(head, head + 1, std::memory_order_release);
+            continue;
+        }
+
+        if (lap > 0) {
+            continue;  // Stale head, another producer moved it meanwhile
+        }
+
+        // Ring is full, use adaptive spin-waiting
+        if (spin_count < MAX_SPIN_COUNT) {
+            ++spin_count;
+        } else if (yield_count < MAX_YIELD_COUNT) {
+            std::this_thread::yield();
+            ++yield_count;
+        } else {
+            // Stop waiting for a consumer that closed the ring, or that died (checked far less often)
+            bool consumer_gone = header_->magic.load(std::memory_order_acquire) != SHM_MAGIC;
+            const auto now = EventClock::now();
+            if (!consumer_gone && now - owner_checked_at >= SHM_STUCK_SLOT_TIMEOUT) {
+                owner_checked_at = now;
+                consumer_gone = !IsProcessAlive(header_->owner_pid.load(std::memory_order_relaxed));
+            }
+            if (consumer_gone) {
+                std::cerr << "Shared memory " << name_ << " has no consumer anymore." << std::endl;
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            yield_count = 0;
+        }
+    }
+}
+
+void SharedMemoryEventQueue::CheckStuckSlot(uint64_t tail, uint64_t state) {
+    const auto now = EventClock::now();
+    if (stuck_position_ != tail) {
+        stuck_position_ = tail;
+        stuck_since_ = now;
+        return;
+    }
+
+    if (now - stuck_since_ < SHM_STUCK_SLOT_TIMEOUT) {
+        return;
+    }
+    stuck_since_ = now;  // Check again after another timeout if the producer is still alive
+
+    if (IsProcessAlive(static_cast<uint32_t>(state & 0xffffffff))) {
+        return;
+    }
+
+    // The producer died between reserving and committing; a late Commit would fail this CAS first
+    SharedSlot& slot = SlotAt(tail);
+    if (!slot.state.compare_exchange_strong(state, MakeState(tail + header_->capacity, 0), std::memory_order_acq_rel)) {
+        return;
+    }
+
+    uint64_t head = tail;
+    header_->head.compare_exchange_strong(head, tail + 1, std::memory_order_release);  // In case it died before moving the head
+    header_->tail.store(tail + 1, std::memory_order_release);
+    header_->abandoned.fetch_add(1, std::memory_order_relaxed);
+    std::cerr << "Skipped event slot " << tail << " abandoned by dead producer " << (state & 0xffffffff) << "." << std::endl;
+}
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "LatencyStats.h"
+
+constexpr size_t SHM_SLOT_PAYLOAD_SIZE = 192;   // Largest event a shared-memory slot can hold
+constexpr size_t SHM_MAX_EVENT_TYPES = 256;     // Valid SharedEventType ids are 1 .. SHM_MAX_EVENT_TYPES - 1
+constexpr uint64_t SHM_MAGIC = 0x4556454e54524e47;  // Marks a fully initialized segment
+constexpr auto SHM_STUCK_SLOT_TIMEOUT = std::chrono::milliseconds(10);  // Wait between liveness checks of a stuck peer
+
+/**
+ * @brief Cross-process id of an event type published through shared memory.
+ *
+ * Producers and the consumer may be different binaries, so every shared event type needs
+ * an explicit, stable id, e.g. `template <> inline constexpr uint32_t SharedEventType<OrderEvent> = 1;`.
+ */
+template <typename T>
+inline constexpr uint32_t SharedEventType = 0;
+
+/**
+ * @struct SharedSlot
+ * @brief One ring slot as laid out in the shared-memory segment.
+ *
+ * The state word packs the 32-bit lap sequence with the pid of the producer holding the slot:
+ * (position, 0) free, (position, pid) reserved, (position + 1, 0) committed.
+ * Claiming a slot and recording its owner is therefore a single CAS.
+ */
+struct alignas(64) SharedSlot {
+    std::atomic<uint64_t> state;
+    uint32_t type_id;
+    uint32_t reserved;
+    int64_t reserved_at_ns;  ///< EventClock (CLOCK_MONOTONIC) time, comparable across processes.
+    alignas(64) std::byte payload[SHM_SLOT_PAYLOAD_SIZE];
+};
+
+/**
+ * @struct SharedRingHeader
+ * @brief Start of the shared-memory segment; slots follow at slots_offset.
+ */
+struct SharedRingHeader {
+    std::atomic<uint64_t> magic;            ///< SHM_MAGIC while a consumer owns the ring, cleared when it goes away.
+    std::atomic<uint32_t> owner_pid;        ///< Pid of the consumer that created the segment.
+    uint64_t pid_namespace;                 ///< Inode of the creator's pid namespace, 0 if unknown.
+    uint64_t capacity;
+    uint64_t slots_offset;
+    std::atomic<uint64_t> abandoned;       ///< Slots reclaimed from producers that died before committing.
+    alignas(64) std::atomic<uint64_t> head;  ///< Next position to reserve.
+    alignas(64) std::atomic<uint64_t> tail;  ///< Next position to consume.
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared-memory queue needs lock-free 64-bit atomics!");
+
+/**
+ * @class SharedMemoryEventQueue
+ * @brief A lock-free, multi-process-producer, single-consumer event ring in POSIX shared memory.
+ *
+ * The consumer creates the named segment (shm_open + mmap); producers in other processes
+ * attach to it and construct trivially-copyable events directly in the slots. Reservations
+ * refer to slots by their offset from the segment start, since every process maps the
+ * segment at a different address.
+ *
+ * If a producer dies after reserving and before committing, the consumer finds its slot
+ * stuck at the tail, confirms the owning process is gone (or a zombie), and skips the slot.
+ * Liveness is checked by pid, so all processes must share one pid namespace; Attach
+ * refuses to join a segment created in a different one.
+ */
+class SharedMemoryEventQueue {
+public:
+    /**
+     * @brief A reserved slot, addressed independently of where the segment is mapped.
+     */
+    struct Reservation {
+        uint64_t sequence = 0;  ///< Position of the slot in the ring.
+        uint64_t offset = 0;    ///< Offset of the event from the segment start, 0 if invalid.
+
+        bool IsValid() const { return offset != 0; }
+    };
+
+    /**
+     * @brief Creates a new named segment and becomes its owner (the consumer).
+     *
+     * A segment left behind by a consumer that died is replaced; one owned by a live
+     * consumer, or not initialized far enough to tell, is not. The segment is unlinked
+     * when the owner is destroyed, unless the name already refers to a newer segment.
+     *
+     * @param name The POSIX shared-memory name, starting with '/'.
+     * @param capacity The number of slots, at least 2.
+     * @return The queue, or nullptr if the segment could not be created.
+     */
+    static std::unique_ptr<SharedMemoryEventQueue> Create(const std::string& name, size_t capacity);
+
+    /**
+     * @brief Attaches to a segment created by another process, for publishing events.
+     *
+     * @param name The POSIX shared-memory name passed to Create.
+     * @return The queue, or nullptr if the segment does not exist, is not initialized or was
+     *         created in another pid namespace.
+     */
+    static std::unique_ptr<SharedMemoryEventQueue> Attach(const std::string& name);
+
+    ~SharedMemoryEventQueue();
+
+    SharedMemoryEventQueue(const SharedMemoryEventQueue&) = delete;
+    SharedMemoryEventQueue& operator=(const SharedMemoryEventQueue&) = delete;
+
+    /**
+     * @brief Reserves a slot and constructs the event in it. Waits while the ring is full.
+     *
+     * @tparam T A trivially-copyable event type with a SharedEventType id.
+     * @param args Arguments for constructing the event.
+     * @return The reservation to pass to Commit, invalid if the consumer has gone away
+     *         and the producer has to attach again.
+     */
+    template <typename T, class... Args>
+    Reservation Reserve(Args&&... args);
+
+    /**
+     * @brief Makes a reserved event visible to the consumer.
+     *
+     * @param reservation The reservation returned by Reserve.
+     * @return False if the consumer already reclaimed the slot, in which case the event is dropped.
+     */
+    bool Commit(const Reservation& reservation);
+
+    /**
+     * @brief Resolves a reservation to the event in this process' mapping.
+     */
+    void* GetEvent(const Reservation& reservation) const { return base_ + reservation.offset; }
+
+    /**
+     * @brief Hands the next committed event to the handler and frees its slot. Consumer only.
+     *
+     * @param handler Called as handler(type_id, event, reserved_at) while the event is still in the slot.
+     * @return False if no committed event was available.
+     */
+    template <typename Handler>
+    bool TryPop(Handler&& handler);
+
+    /**
+     * @brief Retrieves the number of slots reclaimed from dead producers.
+     */
+    uint64_t AbandonedCount() const { return header_->abandoned.load(std::memory_order_relaxed); }
+
+private:
+    SharedMemoryEventQueue(std::string name, std::byte* base, size_t size, uint64_t owned_inode);
+
+    static uint64_t MakeState(uint64_t position, uint32_t pid) { return ((position & 0xffffffff) << 32) | pid; }
+
+    SharedSlot& SlotAt(uint64_t position) const;
+
+    /**
+     * @brief Claims the slot at the head for this process, waiting while the ring is full.
+     * @param position Set to the position of the claimed slot.
+     * @return False if the consumer went away while the ring was full.
+     */
+    bool ClaimSlot(uint64_t& position);
+
+    /**
+     * @brief Called when the tail slot is reserved but not committed; skips it if its producer is dead.
+     */
+    void CheckStuckSlot(uint64_t tail, uint64_t state);
+
+    std::string name_;
+    std::byte* base_;
+    size_t size_;
+    uint64_t owned_inode_;  ///< Inode of the segment this consumer created, 0 for producers.
+    uint32_t pid_;
+    SharedRingHeader* header_;
+    uint64_t stuck_position_ = UINT64_MAX;  ///< Consumer-only: tail position seen stuck.
+    EventClock::time_point stuck_since_;    ///< Consumer-only: when the stuck slot was first seen.
+};
+
+template <typename T, class... Args>
+SharedMemoryEventQueue::Reservation SharedMemoryEventQueue::Reserve(Args&&... args) {
+    static_assert(std::is_trivially_copyable_v<T>, "Shared-memory events must be trivially copyable!");
+    static_assert(sizeof(T) <= SHM_SLOT_PAYLOAD_SIZE, "Event type is too large for a shared-memory slot!");
+    static_assert(alignof(T) <= alignof(SharedSlot), "Event type is over-aligned for a shared-memory slot!");
+    static_assert(SharedEventType<T> != 0 && SharedEventType<T> < SHM_MAX_EVENT_TYPES,
+                  "Specialize SharedEventType with a valid id for this event type!");
+
+    const auto reserved_at = EventClock::now();
+    uint64_t position = 0;
+    if (!ClaimSlot(position)) {
+        return {};
+    }
+    SharedSlot& slot = SlotAt(position);
+
+    slot.type_id = SharedEventType<T>;
+    slot.reserved_at_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(reserved_at.time_since_epoch()).count();
+    std::construct_at(reinterpret_cast<T*>(slot.payload), std::forward<Args>(args)...);
+
+    return {position, static_cast<uint64_t>(slot.payload - base_)};
+}
+
+template <typename Handler>
+bool SharedMemoryEventQueue::TryPop(Handler&& handler) {
+    const uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+    SharedSlot& slot = SlotAt(tail);
+    const uint64_t state = slot.state.load(std::memory_order_acquire);
+
+    if (state != MakeState(tail + 1, 0)) {
+        if ((state >> 32) == (tail & 0xffffffff) && (state & 0xffffffff) != 0) {
+            CheckStuckSlot(tail, state);  // Reserved but not committed yet
+        }
+        return false;
+    }
+
+    const EventClock::time_point reserved_at{std::chrono::nanoseconds(slot.reserved_at_ns)};
+    handler(slot.type_id, static_cast<void*>(slot.payload), reserved_at);
+
+    slot.state.store(MakeState(tail + header_->capacity, 0), std::memory_order_release);  // Free for the next lap
+    header_->tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstddef>
+
+// Adaptive spin-waiting shared by the in-process and shared-memory queues and the worker:
+// spin, then yield, then sleep briefly before starting over
+constexpr size_t MAX_SPIN_COUNT = 1000;  // Number of spins before yielding CPU
+constexpr size_t MAX_YIELD_COUNT = 10;   // Number of yields before sleeping
@@ -5,7 +5,13 @@
 #include <atomic>
 #include <variant>
 #include <random>
+#include <sstream>
 #include <functional>
+#include <string>
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include "IEventProcessor.h"
 #include "Event.h"
@@ -13,18 +19,199 @@
 // Define a function to publish single events
 template <typename TEvent, typename... Args>
 void worker(IEventProcessor& processor, size_t count, Args&&... args) {
-    for (size_t i = 0; i < count; ++i) {
-        // Correctly call PublishSingleEvents with the processor and count
-        processor.PublishSingleEvents<TEvent>(processor, count, std::forward<Args>(args)...);
+    // PublishSingleEvents already loops count times
+    processor.PublishSingleEvents<TEvent>(processor, count, std::forward<Args>(args)...);
+}
+
+// Event used by the lane benchmark; larger than a slot, so it goes through the event pool
+struct BenchmarkEvent {
+    explicit BenchmarkEvent(const int value) : value_(value) {}
+    void Process() { payload_[0] = static_cast<char>(value_); }
+
+    int value_;
+    char payload_[60] = {};
+};
+
+// Publishes paced events to lane 0, optionally while saturating the bulk lanes; returns each lane's printed stats
+std::vector<std::string> RunLaneBenchmark(const DrainPolicy policy, const bool saturate) {
+    constexpr size_t bulk_threads_per_lane = 2;
+    constexpr auto duration = std::chrono::seconds(3);
+    constexpr auto priority_interval = std::chrono::microseconds(50);
+
+    LaneConfig config;
+    config.lane_count = 3;
+    config.policy = policy;
+    config.weights = {8, 1, 1};
+
+    IEventProcessor processor(config);
+    std::atomic<bool> done(false);
+    std::vector<std::thread> threads;
+
+    // Bulk producers for lanes 1 and 2, publishing as fast as the lanes accept events
+    for (size_t lane = 1; saturate && lane < config.lane_count; ++lane) {
+        for (size_t i = 0; i < bulk_threads_per_lane; ++i) {
+            threads.emplace_back([&processor, &done, lane] {
+                while (!done) {
+                    auto reserved_event = processor.ReserveInLane<BenchmarkEvent>(lane, 1);
+                    processor.Commit(reserved_event.GetSequenceNumber());
+                }
+            });
+        }
+    }
+
+    // High-priority producer for lane 0, on a fixed schedule so both runs target the same rate
+    threads.emplace_back([&processor, &done, duration, priority_interval] {
+        const auto start = std::chrono::steady_clock::now();
+        for (auto next = start; next < start + duration; next += priority_interval) {
+            std::this_thread::sleep_until(next);
+            auto reserved_event = processor.ReserveInLane<BenchmarkEvent>(0, 0);
+            processor.Commit(reserved_event.GetSequenceNumber());
+        }
+        done = true;
+    });
+
+    for (auto& t : threads) {
+        t.join();
     }
+
+    std::vector<std::string> lane_stats;
+    for (size_t lane = 0; lane < processor.LaneCount(); ++lane) {
+        std::ostringstream out;
+        processor.GetLaneStats(lane).Print(out);
+        lane_stats.push_back(out.str());
+    }
+    return lane_stats;
 }
 
-// Define a function to process events from the queue (read thread)
-void ProcessEvents(IEventProcessor& processor) {
-    processor.ProcessEvents(); // Assuming this method processes events
+// Prints per-lane latency without and with saturated bulk lanes, side by side
+void PrintLaneBenchmark(const DrainPolicy policy) {
+    const auto unloaded = RunLaneBenchmark(policy, false);
+    const auto saturated = RunLaneBenchmark(policy, true);
+
+    std::cout << (policy == DrainPolicy::StrictPriority ? "StrictPriority" : "WeightedRoundRobin") << std::endl;
+    for (size_t lane = 0; lane < unloaded.size(); ++lane) {
+        std::cout << "  lane " << lane << " unloaded:  " << unloaded[lane] << std::endl;
+        std::cout << "  lane " << lane << " saturated: " << saturated[lane] << std::endl;
+    }
+}
+
+// Event published by the producer processes of the shared-memory demo
+struct ShmDemoEvent {
+    int64_t value;
+    void Process() { total += value; }
+
+    static inline std::atomic<int64_t> total{0};  // Only touched by the consumer's worker
+};
+
+template <>
+inline constexpr uint32_t SharedEventType<ShmDemoEvent> = 1;
+
+// Publishes events from forked producers; one is killed between Reserve and Commit
+int RunSharedMemoryDemo() {
+    constexpr const char* name = "/event_processor_shm_demo";
+    constexpr size_t producer_count = 3;
+    constexpr size_t events_per_producer = 100000;
+    constexpr size_t events_before_crash = 1000;
+
+    // Fork before the processor starts its worker thread; producers wait until the ring exists
+    int start_pipe[2];
+    int reserved_pipe[2];
+    if (pipe(start_pipe) != 0 || pipe(reserved_pipe) != 0) {
+        std::cerr << "Failed to create the demo pipes." << std::endl;
+        return 1;
+    }
+
+    std::vector<pid_t> producers;
+    for (size_t i = 0; i < producer_count; ++i) {
+        const pid_t pid = fork();
+        if (pid == -1) {
+            std::cerr << "Failed to fork producer " << i << "." << std::endl;
+            return 1;
+        }
+        if (pid != 0) {
+            producers.push_back(pid);
+            continue;
+        }
+
+        close(start_pipe[1]);
+        char byte = 0;
+        (void)read(start_pipe[0], &byte, 1);  // Returns once the consumer closes the pipe
+
+        auto queue = SharedMemoryEventQueue::Attach(name);
+        if (!queue) {
+            _exit(1);
+        }
+
+        const bool crashes = i == 0;
+        const size_t count = crashes ? events_before_crash : events_per_producer;
+        for (size_t n = 0; n < count; ++n) {
+            const auto reservation = queue->Reserve<ShmDemoEvent>(1);
+            if (!reservation.IsValid() || !queue->Commit(reservation)) {
+                _exit(1);
+            }
+        }
+
+        if (crashes) {
+            // Hold a reservation and wait to be killed before committing it
+            queue->Reserve<ShmDemoEvent>(1000000);
+            (void)write(reserved_pipe[1], &byte, 1);
+            pause();
+        }
+        _exit(0);
+    }
+    close(start_pipe[0]);
+    close(reserved_pipe[1]);
+
+    IEventProcessor processor(LaneConfig{}, SharedMemoryConfig{name, 1024, 64});
+    if (!processor.GetSharedMemoryQueue()) {
+        close(start_pipe[1]);
+        for (const pid_t pid : producers) {
+            waitpid(pid, nullptr, 0);
+        }
+        return 1;
+    }
+    processor.RegisterSharedEvent<ShmDemoEvent>();
+    close(start_pipe[1]);
+
+    char byte = 0;
+    if (read(reserved_pipe[0], &byte, 1) == 1) {
+        kill(producers[0], SIGKILL);
+        std::cout << "Killed producer " << producers[0] << " holding an uncommitted reservation." << std::endl;
+    }
+    close(reserved_pipe[0]);
+
+    for (const pid_t pid : producers) {
+        waitpid(pid, nullptr, 0);
+    }
+
+    // The worker skips the abandoned slot once it has been stuck for SHM_STUCK_SLOT_TIMEOUT
+    const uint64_t committed = events_before_crash + (producer_count - 1) * events_per_producer;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (processor.GetSharedMemoryStats().Count() < committed && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    std::cout << "committed=" << committed
+              << " processed=" << processor.GetSharedMemoryStats().Count()
+              << " abandoned=" << processor.GetSharedMemoryQueue()->AbandonedCount()
+              << " sum=" << ShmDemoEvent::total << std::endl;
+    std::cout << "shared memory: ";
+    processor.GetSharedMemoryStats().Print(std::cout);
+    std::cout << std::endl;
+    return processor.GetSharedMemoryStats().Count() == committed ? 0 : 1;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--lane-benchmark") {
+        PrintLaneBenchmark(DrainPolicy::StrictPriority);
+        PrintLaneBenchmark(DrainPolicy::WeightedRoundRobin);
+        return 0;
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "--shm-demo") {
+        return RunSharedMemoryDemo();
+    }
+
     IEventProcessor processor;
 
     const size_t numEvents = 10000000;  // 10 million events for demonstration
@@ -35,10 +222,9 @@ int main() {
     // Correctly call the worker function
     threads.push_back(std::thread(worker<Event<int>, int>, std::ref(processor), numEvents, 1));
 
-    // Thread for reading events (processing events)
-    threads.push_back(std::thread(ProcessEvents, std::ref(processor)));
+    // Events are processed by the processor's own worker thread
 
-    // Wait for both threads to finish
+    // Wait for the writer to finish
     for (auto& t : threads) {
         t.join();
     }